@@ -23,6 +23,7 @@
  */
 
 #include "Adafruit_ZeroI2S.h"
+#include "Adafruit_ZeroI2S_Cycles.h"
 #include "wiring_private.h"
 
 #ifndef DEBUG_PRINTLN
@@ -69,14 +70,45 @@ Adafruit_ZeroI2S::Adafruit_ZeroI2S()
         @param fs_freq the frame sync frequency (a.k.a. sample rate)
         @param mck_mult master clock output will be fs_freq * mck_mult for chips
    that have a mclk. This should be a multiple of the width.
+        @param mode where the I2S clocks come from. In I2S_CLOCK_SLAVE mode
+   fs_freq and mck_mult are ignored and the sample rate is set by whatever is
+   driving the SCK and FS pins. In I2S_CLOCK_MCK_IN mode fs_freq is ignored and
+   the sample rate is the MCK pin frequency / mck_mult.
         @returns true on success, false on any error
 */
 /**************************************************************************/
-bool Adafruit_ZeroI2S::begin(I2SSlotSize width, int fs_freq, int mck_mult) {
+bool Adafruit_ZeroI2S::begin(I2SSlotSize width, int fs_freq, int mck_mult,
+                             I2SClockMode mode) {
+  ZEROI2S_PROFILE_INIT();
+
 #if defined(__SAMD51__)
 
+  // This is the size of an I2S frame: one sample at the given bit
+  // width for every I2S slot (in stereo, the "slots" are the left and
+  // right channels).
+  uint32_t frameSize = I2S_NUM_SLOTS * ((width + 1) << 3);
+
+  // Check the MCK input settings before we touch any hardware, so that a
+  // bad call leaves a running I2S alone.
+  if (mode == I2S_CLOCK_MCK_IN) {
+#ifndef PIN_I2S_MCK
+    DEBUG_PRINTLN("This board has no MCK pin");
+    return false;
+#endif
+    // As with the GCLK case, mck_mult must be a multiple of frameSize.
+    uint32_t mckdiv = mck_mult / frameSize;
+    if (mckdiv < 1 || mckdiv > 32 || (mck_mult % frameSize) != 0) {
+      DEBUG_PRINTLN("mck_mult isnt a valid multiple of the frame size");
+      return false;
+    }
+  }
+
   pinPeripheral(_fs, PIO_I2S);
   pinPeripheral(_sck, PIO_I2S);
+#ifdef PIN_I2S_MCK
+  if (mode == I2S_CLOCK_MCK_IN)
+    pinPeripheral(PIN_I2S_MCK, PIO_I2S);
+#endif
   if (_rx != -1)
     pinPeripheral(_rx, PIO_I2S);
   pinPeripheral(_tx, PIO_I2S);
@@ -86,74 +118,97 @@ bool Adafruit_ZeroI2S::begin(I2SSlotSize width, int fs_freq, int mck_mult) {
   // initialize clock control
   MCLK->APBDMASK.reg |= MCLK_APBDMASK_I2S;
 
-  // This is the size of an I2S frame: one sample at the given bit
-  // width for every I2S slot (in stereo, the "slots" are the left and
-  // right channels).
-  uint32_t frameSize = I2S_NUM_SLOTS * ((width + 1) << 3);
-
-  // We need to set up two I2S clocks, MCK and SCK, using the SAMD51's
-  // available GCLKs and the two clock dividers it provides for this
-  // purpose, mckoutdiv and mckdiv (somewhat unhelpfully named).
-
-  // This is the correct frequency we'd ideally like to run MCK at:
-  // mck_mult ticks per sample, fs_freq samples per second.
-  uint32_t nominalMckFreq = (fs_freq * mck_mult);
-
-  // And we'd ideally like to run SCK at frameSize ticks per sample,
-  // fs_freq samples per second.
+  // Every mode shares the slot layout and I2S framing, only the clock
+  // sources differ.
+  uint32_t clkctrl = I2S_CLKCTRL_BITDELAY_I2S | I2S_CLKCTRL_FSWIDTH_HALF |
+                     I2S_CLKCTRL_NBSLOTS(I2S_NUM_SLOTS - 1) |
+                     I2S_CLKCTRL_SLOTSIZE(width);
 
-  // But without an external clock, we'll have to make do with the
-  // GCLKs provided by the SAMD51. We can set a divider, mckoutdiv, to
-  // get as close as possible to nominalMckFreq as we can using an int
-  // divider.
+  // The peripheral still needs a GCLK for register synchronization even
+  // when the bit clock comes from outside.
   uint32_t gclkval = GCLK_PCHCTRL_GEN_GCLK1_Val;
-  uint32_t gclkFreq = VARIANT_GCLK1_FREQ;
-  uint32_t mckoutdiv =
-      max((gclkFreq + (nominalMckFreq / 2)) / nominalMckFreq, 1);
-  if (mckoutdiv > 64) {
-    // 64 is the max, so we'll have to start from a slower GCLK.
-    gclkval = GCLK_PCHCTRL_GEN_GCLK4_Val;
-    gclkFreq = 12000000;
-    mckoutdiv = min((gclkFreq + (nominalMckFreq / 2)) / nominalMckFreq, 64);
-  }
-
-  // mckoutdiv divides the GCLK to get our real MCK frequency
-  // uint32_t realMckFreq = gclkFreq / mckoutdiv;
 
-  // Note that because our real clock rates are only an approximation
-  // of the nominal rate, our real sample rate is only an
-  // approximation of fs_freq. Here's how you would calculate the
-  // actual rate:
-  // float realFsFreq = static_cast<float>(realMckFreq) / mck_mult;
-
-  // mckdiv also divides the GCLK, to get our real SCK frequency. To
-  // work well, it needs to divide evenly into the MCK frequency. This
-  // is only possible if mck_mult (MCK's ticks per sample) is
-  // divisible by frameSize (SCK's ticks per sample), so users should
-  // choose mck_mult and width accordingly.
+  if (mode == I2S_CLOCK_SLAVE) {
+    // The external master drives both SCK and FS, so the dividers are
+    // unused and the sample rate is exactly what the master provides.
+    // FSINV mirrors the FSOUTINV we use as master so that slot 0 is
+    // still the left channel.
+    clkctrl |= I2S_CLKCTRL_SCKSEL_SCKPIN | I2S_CLKCTRL_FSSEL_FSPIN |
+               I2S_CLKCTRL_FSINV;
+  } else if (mode == I2S_CLOCK_MCK_IN) {
+    // MCK comes in on the MCK pin and we divide it down to SCK, so
+    // SCK and FS are locked to the external oscillator. mckdiv was
+    // checked above.
+    uint32_t mckdiv = mck_mult / frameSize;
+    clkctrl |= I2S_CLKCTRL_MCKSEL_MCKPIN | I2S_CLKCTRL_MCKDIV(mckdiv - 1) |
+               I2S_CLKCTRL_SCKSEL_MCKDIV | I2S_CLKCTRL_FSSEL_SCKDIV |
+               I2S_CLKCTRL_FSOUTINV;
+  } else {
+    // We need to set up two I2S clocks, MCK and SCK, using the SAMD51's
+    // available GCLKs and the two clock dividers it provides for this
+    // purpose, mckoutdiv and mckdiv (somewhat unhelpfully named).
+
+    // This is the correct frequency we'd ideally like to run MCK at:
+    // mck_mult ticks per sample, fs_freq samples per second.
+    uint32_t nominalMckFreq = (fs_freq * mck_mult);
+
+    // And we'd ideally like to run SCK at frameSize ticks per sample,
+    // fs_freq samples per second.
+
+    // But without an external clock, we'll have to make do with the
+    // GCLKs provided by the SAMD51. We can set a divider, mckoutdiv, to
+    // get as close as possible to nominalMckFreq as we can using an int
+    // divider.
+    uint32_t gclkFreq = VARIANT_GCLK1_FREQ;
+    uint32_t mckoutdiv =
+        max((gclkFreq + (nominalMckFreq / 2)) / nominalMckFreq, 1);
+    if (mckoutdiv > 64) {
+      // 64 is the max, so we'll have to start from a slower GCLK.
+      gclkval = GCLK_PCHCTRL_GEN_GCLK4_Val;
+      gclkFreq = 12000000;
+      mckoutdiv = min((gclkFreq + (nominalMckFreq / 2)) / nominalMckFreq, 64);
+    }
 
-  // Instead of dividing GCLK into mck_mult ticks per sample as
-  // mckoutdiv does, mckdiv divides it into frameSize ticks per
-  // sample. This is equivalent to directly dividing gclkFreq by
-  // (realFsFreq * frameSize), but avoids using the (possibly
-  // non-integer) realFsFreq.
-  uint32_t mckdiv = (mckoutdiv * mck_mult) / frameSize;
+    // mckoutdiv divides the GCLK to get our real MCK frequency
+    // uint32_t realMckFreq = gclkFreq / mckoutdiv;
+
+    // Note that because our real clock rates are only an approximation
+    // of the nominal rate, our real sample rate is only an
+    // approximation of fs_freq. Here's how you would calculate the
+    // actual rate:
+    // float realFsFreq = static_cast<float>(realMckFreq) / mck_mult;
+
+    // mckdiv also divides the GCLK, to get our real SCK frequency. To
+    // work well, it needs to divide evenly into the MCK frequency. This
+    // is only possible if mck_mult (MCK's ticks per sample) is
+    // divisible by frameSize (SCK's ticks per sample), so users should
+    // choose mck_mult and width accordingly.
+
+    // Instead of dividing GCLK into mck_mult ticks per sample as
+    // mckoutdiv does, mckdiv divides it into frameSize ticks per
+    // sample. This is equivalent to directly dividing gclkFreq by
+    // (realFsFreq * frameSize), but avoids using the (possibly
+    // non-integer) realFsFreq.
+    uint32_t mckdiv = (mckoutdiv * mck_mult) / frameSize;
+
+    clkctrl |= I2S_CLKCTRL_MCKSEL_GCLK | I2S_CLKCTRL_MCKOUTDIV(mckoutdiv - 1) |
+               I2S_CLKCTRL_MCKDIV(mckdiv - 1) | I2S_CLKCTRL_SCKSEL_MCKDIV |
+               I2S_CLKCTRL_MCKEN | I2S_CLKCTRL_FSSEL_SCKDIV |
+               I2S_CLKCTRL_FSOUTINV;
+  }
 
   GCLK->PCHCTRL[I2S_GCLK_ID_0].reg = gclkval | (1 << GCLK_PCHCTRL_CHEN_Pos);
   GCLK->PCHCTRL[I2S_GCLK_ID_1].reg = gclkval | (1 << GCLK_PCHCTRL_CHEN_Pos);
 
   // software reset
+  ZEROI2S_PROFILE_START(swrstStart);
   I2S->CTRLA.bit.SWRST = 1;
   while (I2S->SYNCBUSY.bit.SWRST || I2S->SYNCBUSY.bit.ENABLE)
     ; // wait for sync
+  ZEROI2S_PROFILE_END(I2S_PROF_BEGIN_SYNC, swrstStart);
 
   // CLKCTRL[0] is used for the tx channel
-  I2S->CLKCTRL[0].reg =
-      I2S_CLKCTRL_MCKSEL_GCLK | I2S_CLKCTRL_MCKOUTDIV(mckoutdiv - 1) |
-      I2S_CLKCTRL_MCKDIV(mckdiv - 1) | I2S_CLKCTRL_SCKSEL_MCKDIV |
-      I2S_CLKCTRL_MCKEN | I2S_CLKCTRL_FSSEL_SCKDIV | I2S_CLKCTRL_BITDELAY_I2S |
-      I2S_CLKCTRL_FSWIDTH_HALF | I2S_CLKCTRL_FSOUTINV |
-      I2S_CLKCTRL_NBSLOTS(I2S_NUM_SLOTS - 1) | I2S_CLKCTRL_SLOTSIZE(width);
+  I2S->CLKCTRL[0].reg = clkctrl;
 
   uint8_t wordSize;
 
@@ -183,8 +238,10 @@ bool Adafruit_ZeroI2S::begin(I2SSlotSize width, int fs_freq, int mck_mult) {
                     I2S_RXCTRL_SLOTADJ_RIGHT | I2S_RXCTRL_CLKSEL_CLK0 |
                     I2S_RXCTRL_SERMODE_RX;
 
+  ZEROI2S_PROFILE_START(enableStart);
   while (I2S->SYNCBUSY.bit.ENABLE)
     ; // wait for sync
+  ZEROI2S_PROFILE_END(I2S_PROF_BEGIN_SYNC, enableStart);
   I2S->CTRLA.bit.ENABLE = 1;
 
   return true;
@@ -192,6 +249,11 @@ bool Adafruit_ZeroI2S::begin(I2SSlotSize width, int fs_freq, int mck_mult) {
 #else // SAMD21
   _i2sserializer = -1;
   _i2sclock = -1;
+  if (mode == I2S_CLOCK_MCK_IN) {
+    // the MCK input pins aren't broken out on any of our SAMD21 boards
+    DEBUG_PRINTLN("MCK input isnt supported on SAMD21");
+    return false;
+  }
   uint32_t _clk_pin, _clk_mux, _data_pin, _data_mux, _fs_pin, _fs_mux;
 
   // Clock pin, can only be one of 3 options
@@ -247,27 +309,37 @@ bool Adafruit_ZeroI2S::begin(I2SSlotSize width, int fs_freq, int mck_mult) {
   else
     i2sGCLK = I2S_GCLK_ID_1;
 
-  uint32_t divider = fs_freq * 2 * (width + 1) * 8;
-  // configure the clock divider
-  while (GCLK->STATUS.bit.SYNCBUSY)
-    ;
-  GCLK->GENDIV.bit.ID = I2S_CLOCK_GENERATOR;
-  GCLK->GENDIV.bit.DIV = SystemCoreClock / divider;
+  if (mode == I2S_CLOCK_SLAVE) {
+    // SCK and FS come from the pins, the GCLK is only needed to clock
+    // the peripheral registers so just hand it the main clock
+    while (GCLK->STATUS.bit.SYNCBUSY)
+      ;
+    GCLK->CLKCTRL.bit.ID = i2sGCLK;
+    GCLK->CLKCTRL.bit.GEN = GCLK_CLKCTRL_GEN_GCLK0_Val;
+    GCLK->CLKCTRL.bit.CLKEN = 1;
+  } else {
+    uint32_t divider = fs_freq * 2 * (width + 1) * 8;
+    // configure the clock divider
+    while (GCLK->STATUS.bit.SYNCBUSY)
+      ;
+    GCLK->GENDIV.bit.ID = I2S_CLOCK_GENERATOR;
+    GCLK->GENDIV.bit.DIV = SystemCoreClock / divider;
 
-  // use the DFLL as the source
-  while (GCLK->STATUS.bit.SYNCBUSY)
-    ;
-  GCLK->GENCTRL.bit.ID = I2S_CLOCK_GENERATOR;
-  GCLK->GENCTRL.bit.SRC = GCLK_GENCTRL_SRC_DFLL48M_Val;
-  GCLK->GENCTRL.bit.IDC = 1;
-  GCLK->GENCTRL.bit.GENEN = 1;
+    // use the DFLL as the source
+    while (GCLK->STATUS.bit.SYNCBUSY)
+      ;
+    GCLK->GENCTRL.bit.ID = I2S_CLOCK_GENERATOR;
+    GCLK->GENCTRL.bit.SRC = GCLK_GENCTRL_SRC_DFLL48M_Val;
+    GCLK->GENCTRL.bit.IDC = 1;
+    GCLK->GENCTRL.bit.GENEN = 1;
 
-  // enable
-  while (GCLK->STATUS.bit.SYNCBUSY)
-    ;
-  GCLK->CLKCTRL.bit.ID = i2sGCLK;
-  GCLK->CLKCTRL.bit.GEN = I2S_CLOCK_GENERATOR;
-  GCLK->CLKCTRL.bit.CLKEN = 1;
+    // enable
+    while (GCLK->STATUS.bit.SYNCBUSY)
+      ;
+    GCLK->CLKCTRL.bit.ID = i2sGCLK;
+    GCLK->CLKCTRL.bit.GEN = I2S_CLOCK_GENERATOR;
+    GCLK->CLKCTRL.bit.CLKEN = 1;
+  }
 
   while (GCLK->STATUS.bit.SYNCBUSY)
     ;
@@ -298,6 +370,7 @@ bool Adafruit_ZeroI2S::begin(I2SSlotSize width, int fs_freq, int mck_mult) {
 
   PM->APBCMASK.reg |= PM_APBCMASK_I2S;
 
+  ZEROI2S_PROFILE_START(disableStart);
   I2S->CTRLA.bit.ENABLE = 0;
   while (I2S->SYNCBUSY.bit.ENABLE)
     ;
@@ -308,11 +381,18 @@ bool Adafruit_ZeroI2S::begin(I2SSlotSize width, int fs_freq, int mck_mult) {
     I2S->CTRLA.bit.CKEN1 = 0;
   while (I2S->SYNCBUSY.bit.CKEN0 || I2S->SYNCBUSY.bit.CKEN1)
     ;
+  ZEROI2S_PROFILE_END(I2S_PROF_BEGIN_SYNC, disableStart);
 
-  I2S->CLKCTRL[_i2sclock].reg =
-      I2S_CLKCTRL_MCKSEL_GCLK | I2S_CLKCTRL_SCKSEL_MCKDIV |
-      I2S_CLKCTRL_FSSEL_SCKDIV | I2S_CLKCTRL_BITDELAY_I2S |
-      I2S_CLKCTRL_NBSLOTS(I2S_NUM_SLOTS - 1) | I2S_CLKCTRL_SLOTSIZE(width);
+  if (mode == I2S_CLOCK_SLAVE)
+    I2S->CLKCTRL[_i2sclock].reg =
+        I2S_CLKCTRL_SCKSEL_SCKPIN | I2S_CLKCTRL_FSSEL_FSPIN |
+        I2S_CLKCTRL_BITDELAY_I2S | I2S_CLKCTRL_NBSLOTS(I2S_NUM_SLOTS - 1) |
+        I2S_CLKCTRL_SLOTSIZE(width);
+  else
+    I2S->CLKCTRL[_i2sclock].reg =
+        I2S_CLKCTRL_MCKSEL_GCLK | I2S_CLKCTRL_SCKSEL_MCKDIV |
+        I2S_CLKCTRL_FSSEL_SCKDIV | I2S_CLKCTRL_BITDELAY_I2S |
+        I2S_CLKCTRL_NBSLOTS(I2S_NUM_SLOTS - 1) | I2S_CLKCTRL_SLOTSIZE(width);
 
   uint8_t wordSize;
   switch (width) {
@@ -333,12 +413,14 @@ bool Adafruit_ZeroI2S::begin(I2SSlotSize width, int fs_freq, int mck_mult) {
     return false;
   }
 
+  ZEROI2S_PROFILE_START(serenStart);
   if (_i2sserializer == 0)
     I2S->CTRLA.bit.SEREN0 = 0;
   else
     I2S->CTRLA.bit.SEREN1 = 0;
   while (I2S->SYNCBUSY.bit.SEREN0 || I2S->SYNCBUSY.bit.SEREN1)
     ;
+  ZEROI2S_PROFILE_END(I2S_PROF_BEGIN_SYNC, serenStart);
 
   I2S->SERCTRL[_i2sserializer].reg =
       I2S_SERCTRL_DMA_SINGLE | I2S_SERCTRL_MONO_STEREO |
@@ -359,6 +441,8 @@ bool Adafruit_ZeroI2S::begin(I2SSlotSize width, int fs_freq, int mck_mult) {
 */
 /**************************************************************************/
 void Adafruit_ZeroI2S::enableTx() {
+  ZEROI2S_PROFILE_SCOPE(I2S_PROF_ENABLE_TX);
+
 #if defined(__SAMD51__)
   I2S->CTRLA.bit.CKEN0 = 1;
   while (I2S->SYNCBUSY.bit.CKEN0)
@@ -401,6 +485,8 @@ void Adafruit_ZeroI2S::enableTx() {
 /**************************************************************************/
 void Adafruit_ZeroI2S::disableTx() {
 #if defined(__SAMD51__)
+  ZEROI2S_PROFILE_SCOPE(I2S_PROF_DISABLE);
+
   I2S->CTRLA.bit.TXEN = 0;
   while (I2S->SYNCBUSY.bit.TXEN)
     ;
@@ -416,6 +502,8 @@ void Adafruit_ZeroI2S::disableTx() {
 */
 /**************************************************************************/
 void Adafruit_ZeroI2S::enableRx() {
+  ZEROI2S_PROFILE_SCOPE(I2S_PROF_ENABLE_RX);
+
 #if defined(__SAMD51__)
   I2S->CTRLA.bit.CKEN0 = 1;
   while (I2S->SYNCBUSY.bit.CKEN0)
@@ -458,6 +546,8 @@ void Adafruit_ZeroI2S::enableRx() {
 /**************************************************************************/
 void Adafruit_ZeroI2S::disableRx() {
 #if defined(__SAMD51__)
+  ZEROI2S_PROFILE_SCOPE(I2S_PROF_DISABLE);
+
   I2S->CTRLA.bit.RXEN = 0;
   while (I2S->SYNCBUSY.bit.RXEN)
     ;
@@ -540,6 +630,8 @@ bool Adafruit_ZeroI2S::rxReady() {
 */
 /**************************************************************************/
 void Adafruit_ZeroI2S::write(int32_t left, int32_t right) {
+  ZEROI2S_PROFILE_SCOPE(I2S_PROF_WRITE);
+
 #if defined(__SAMD51__)
   while ((!I2S->INTFLAG.bit.TXRDY0) || I2S->SYNCBUSY.bit.TXDATA)
     ;
@@ -586,6 +678,8 @@ void Adafruit_ZeroI2S::write(int32_t left, int32_t right) {
 */
 /**************************************************************************/
 void Adafruit_ZeroI2S::read(int32_t *left, int32_t *right) {
+  ZEROI2S_PROFILE_SCOPE(I2S_PROF_READ);
+
 #if defined(__SAMD51__)
   while ((!I2S->INTFLAG.bit.RXRDY0) || I2S->SYNCBUSY.bit.RXDATA)
     ;
@@ -616,3 +710,100 @@ void Adafruit_ZeroI2S::read(int32_t *left, int32_t *right) {
   }
 #endif
 }
+
+// Wait for a rising edge on a PORT input, giving up once more than limit
+// cycles have passed since start.
+static inline bool waitRisingEdge(volatile uint32_t *in, uint32_t mask,
+                                  uint32_t start, uint32_t limit) {
+  while (*in & mask)
+    if (zeroi2s_cycles_now() - start > limit)
+      return false;
+  while (!(*in & mask))
+    if (zeroi2s_cycles_now() - start > limit)
+      return false;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  measure the frame sync rate on the FS pin by counting frames
+   against the CPU cycle counter. This works in any clock mode, and in slave
+   mode is the way to find out what rate the external master is running at.
+   Interrupts are masked while frames are timed, but only in chunks of a few
+   hundred microseconds, so that an ISR can't hide an edge while millis() and
+   USB keep running in between. Rates down to about 8kHz are supported.
+        @param frames how many frames to time. The result is only as accurate
+   as the CPU clock, more frames just reduce the rounding.
+        @param timeout_ms stop after sampling FS for this long. This counts
+   cycles spent sampling rather than millis(), so it also works when called
+   with interrupts masked.
+        @returns the sample rate in Hz, or 0 if FS isn't toggling. If the
+   timeout runs out first, the rate is worked out from the frames counted so
+   far.
+*/
+/**************************************************************************/
+uint32_t Adafruit_ZeroI2S::measureSampleRate(uint32_t frames,
+                                             uint32_t timeout_ms) {
+  if (frames == 0)
+    return 0;
+
+  uint32_t port = g_APinDescription[_fs].ulPort;
+  uint32_t pin = g_APinDescription[_fs].ulPin;
+  uint32_t mask = 1ul << pin;
+
+  // the pin is muxed to the I2S peripheral, but we can still sample its
+  // level through the PORT as long as the input buffer is on
+  uint8_t inen = PORT->Group[port].PINCFG[pin].bit.INEN;
+  PORT->Group[port].PINCFG[pin].bit.INEN = 1;
+  volatile uint32_t *in = &PORT->Group[port].IN.reg;
+
+  zeroi2s_cycles_enable();
+
+  // each chunk waits at most two budgets for its first edge and counts for
+  // at most two more, which keeps it under half a SysTick period so that
+  // zeroi2s_cycles_now() can account for a reload on the M0+
+  uint32_t budget = SystemCoreClock / 10000;
+  uint64_t timeout = (uint64_t)timeout_ms * (SystemCoreClock / 1000);
+  uint64_t spent = 0;
+  uint32_t counted = 0;
+  uint64_t cycles = 0;
+
+  while (counted < frames && spent < timeout) {
+    uint32_t n = 0, elapsed = 0;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t chunkStart = zeroi2s_cycles_now();
+    // line up on a rising edge so that we time whole frames
+    if (waitRisingEdge(in, mask, chunkStart, 2 * budget)) {
+      uint32_t t0 = zeroi2s_cycles_now();
+      while (n < frames - counted && zeroi2s_cycles_now() - t0 < budget) {
+        if (!waitRisingEdge(in, mask, t0, 2 * budget))
+          break;
+        elapsed = zeroi2s_cycles_now() - t0;
+        n++;
+      }
+    }
+    uint32_t chunkCycles = zeroi2s_cycles_now() - chunkStart;
+    __set_PRIMASK(primask);
+
+    // If our caller has interrupts masked, SysTick reloads can go
+    // unaccounted on the M0+. A chunk can't really take longer than four
+    // budgets, so throw away any that claim to rather than trust them.
+    if (chunkCycles > 4 * budget) {
+      chunkCycles = 4 * budget;
+      n = 0;
+    }
+    spent += chunkCycles;
+    if (n) {
+      counted += n;
+      cycles += elapsed;
+    }
+  }
+
+  PORT->Group[port].PINCFG[pin].bit.INEN = inen;
+
+  if (counted == 0 || cycles == 0)
+    return 0;
+  return ((uint64_t)counted * SystemCoreClock + cycles / 2) / cycles;
+}
@@ -19,6 +19,8 @@
 
 #include <Arduino.h>
 
+#include "Adafruit_ZeroI2S_Profile.h"
+
 /**************************************************************************/
 /*!
     @brief  available I2S slot sizes
@@ -31,6 +33,17 @@ typedef enum _I2SSlotSize {
   I2S_32_BIT
 } I2SSlotSize;
 
+/**************************************************************************/
+/*!
+    @brief  where the I2S clocks come from
+*/
+/**************************************************************************/
+typedef enum _I2SClockMode {
+  I2S_CLOCK_MASTER = 0, ///< MCK, SCK and FS are generated from a GCLK
+  I2S_CLOCK_SLAVE,      ///< SCK and FS are inputs from an external master
+  I2S_CLOCK_MCK_IN      ///< MCK is an input, SCK and FS are divided from it
+} I2SClockMode;
+
 /**************************************************************************/
 /*!
     @brief  number of I2S slots to use (stereo)
@@ -51,7 +64,8 @@ public:
   Adafruit_ZeroI2S();
   ~Adafruit_ZeroI2S() {}
 
-  bool begin(I2SSlotSize width, int fs_freq, int mck_mult = 256);
+  bool begin(I2SSlotSize width, int fs_freq, int mck_mult = 256,
+             I2SClockMode mode = I2S_CLOCK_MASTER);
 
   void enableTx();
   void disableTx();
@@ -65,6 +79,9 @@ public:
   void write(int32_t left, int32_t right);
   void read(int32_t *left, int32_t *right);
 
+  uint32_t measureSampleRate(uint32_t frames = 4096,
+                             uint32_t timeout_ms = 1000);
+
 private:
   int8_t _fs, _sck, _tx, _rx;
 #ifndef __SAMD51__
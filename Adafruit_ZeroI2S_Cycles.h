@@ -0,0 +1,65 @@
+/*!
+ * @file Adafruit_ZeroI2S_Cycles.h
+ *
+ * Internal CPU cycle counter used by Adafruit_ZeroI2S::measureSampleRate()
+ * and the optional profiling probes. This is always compiled, whether or not
+ * profiling is enabled.
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef ADAFRUIT_ZEROI2S_CYCLES_H
+#define ADAFRUIT_ZEROI2S_CYCLES_H
+
+#include <Arduino.h>
+
+/**************************************************************************/
+/*!
+    @brief  start the free running cycle counter if it isn't already. On the
+   M0+ SysTick is already running for millis(), so this does nothing.
+*/
+/**************************************************************************/
+static inline void zeroi2s_cycles_enable() {
+#if (__CORTEX_M >= 3)
+  if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  }
+#endif
+}
+
+/**************************************************************************/
+/*!
+    @brief  read the free running cycle counter
+    @returns the current cycle count. Only the difference between two reads
+   is meaningful, and it wraps after 2^32 cycles.
+*/
+/**************************************************************************/
+static inline uint32_t zeroi2s_cycles_now() {
+#if (__CORTEX_M >= 3)
+  return DWT->CYCCNT;
+#else
+  // SysTick counts down once per cycle and reloads every millisecond, so
+  // stitch it together with the millisecond count. If it reloaded but the
+  // tick interrupt hasn't run yet (we may be in an ISR) count the pending
+  // tick ourselves, just like micros() does.
+  uint32_t load = SysTick->LOAD + 1;
+  uint32_t ms, val, pend;
+  do {
+    ms = millis();
+    val = SysTick->VAL;
+    pend = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+  } while (ms != millis());
+  if (pend && val > (load >> 1))
+    ms++;
+  return ms * load + (load - 1 - val);
+#endif
+}
+
+#endif
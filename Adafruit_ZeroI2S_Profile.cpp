@@ -0,0 +1,133 @@
+/*!
+ * @file Adafruit_ZeroI2S_Profile.cpp
+ *
+ * Optional cycle profiling probes for the Adafruit_ZeroI2S driver.
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_ZeroI2S_Profile.h"
+
+#if ZEROI2S_PROFILE
+
+static I2SProfileStats _stats[I2S_PROF_NUM_REGIONS];
+
+static const char *const _names[I2S_PROF_NUM_REGIONS] = {
+    "begin sync", "enable tx", "enable rx",    "disable",
+    "write",      "read",      "dma callback", "user"};
+
+/**************************************************************************/
+/*!
+    @brief  start the cycle counter. This is called by begin(), so sketches
+   only need it if they profile before starting I2S.
+*/
+/**************************************************************************/
+void zeroi2s_profile_init() { zeroi2s_cycles_enable(); }
+
+/**************************************************************************/
+/*!
+    @brief  clear the statistics of every region
+*/
+/**************************************************************************/
+void zeroi2s_profile_reset() {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  memset(_stats, 0, sizeof(_stats));
+  __set_PRIMASK(primask);
+}
+
+/**************************************************************************/
+/*!
+    @brief  add a sample to a region. Safe to call from interrupts.
+        @param region the region to record into
+        @param cycles the length of the sample in cycles
+*/
+/**************************************************************************/
+void zeroi2s_profile_record(I2SProfileRegion region, uint32_t cycles) {
+  if (region >= I2S_PROF_NUM_REGIONS)
+    return;
+
+  // bucket n holds samples of less than 2^n cycles, the last one holds
+  // everything longer
+  uint8_t bucket = cycles ? 32 - __builtin_clz(cycles) : 0;
+  if (bucket >= ZEROI2S_PROFILE_BUCKETS)
+    bucket = ZEROI2S_PROFILE_BUCKETS - 1;
+
+  I2SProfileStats *s = &_stats[region];
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (s->count == 0 || cycles < s->min)
+    s->min = cycles;
+  if (cycles > s->max)
+    s->max = cycles;
+  s->count++;
+  s->total += cycles;
+  s->hist[bucket]++;
+  __set_PRIMASK(primask);
+}
+
+/**************************************************************************/
+/*!
+    @brief  get a consistent copy of the statistics of a region, taken with
+   interrupts masked so that a probe in an ISR can't update it halfway
+        @param region the region to look up
+        @param out where to copy the statistics
+        @returns true on success, false for an invalid region
+*/
+/**************************************************************************/
+bool zeroi2s_profile_stats(I2SProfileRegion region, I2SProfileStats *out) {
+  if (region >= I2S_PROF_NUM_REGIONS || out == NULL)
+    return false;
+
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  *out = _stats[region];
+  __set_PRIMASK(primask);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  print the statistics of every region that has samples
+        @param out where to print them
+*/
+/**************************************************************************/
+void zeroi2s_profile_dump(Print &out) {
+  out.print("I2S profile, cycles @ ");
+  out.print(SystemCoreClock);
+  out.println(" Hz");
+
+  for (uint8_t r = 0; r < I2S_PROF_NUM_REGIONS; r++) {
+    // copy so that interrupts can keep recording while we print
+    I2SProfileStats s;
+    zeroi2s_profile_stats((I2SProfileRegion)r, &s);
+    if (s.count == 0)
+      continue;
+
+    out.print(_names[r]);
+    out.print(": n=");
+    out.print(s.count);
+    out.print(" min=");
+    out.print(s.min);
+    out.print(" avg=");
+    out.print((uint32_t)(s.total / s.count));
+    out.print(" max=");
+    out.println(s.max);
+
+    for (uint8_t b = 0; b < ZEROI2S_PROFILE_BUCKETS; b++) {
+      if (s.hist[b] == 0)
+        continue;
+      out.print(b == ZEROI2S_PROFILE_BUCKETS - 1 ? "  >=2^" : "  <2^");
+      out.print(b == ZEROI2S_PROFILE_BUCKETS - 1 ? b - 1 : b);
+      out.print(": ");
+      out.println(s.hist[b]);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,139 @@
+/*!
+ * @file Adafruit_ZeroI2S_Profile.h
+ *
+ * Optional cycle profiling probes for the Adafruit_ZeroI2S driver.
+ *
+ * Profiling is off by default and every probe compiles to nothing. Build with
+ * ZEROI2S_PROFILE defined to 1 (for example with a -D build flag, since a
+ * #define in the sketch isn't seen when the library is compiled) to turn it
+ * on. Cycles are counted with zeroi2s_cycles_now(), see
+ * Adafruit_ZeroI2S_Cycles.h.
+ *
+ * Adafruit invests time and resources providing this open source code,
+ * please support Adafruit and open-source hardware by purchasing
+ * products from Adafruit!
+ *
+ * BSD license, all text here must be included in any redistribution.
+ *
+ */
+
+#ifndef ADAFRUIT_ZEROI2S_PROFILE_H
+#define ADAFRUIT_ZEROI2S_PROFILE_H
+
+#include <Arduino.h>
+
+#include "Adafruit_ZeroI2S_Cycles.h"
+
+#ifndef ZEROI2S_PROFILE
+#define ZEROI2S_PROFILE 0 ///< set to 1 to enable the profiling probes
+#endif
+
+#ifndef ZEROI2S_PROFILE_BUCKETS
+#define ZEROI2S_PROFILE_BUCKETS 16 ///< number of log2 histogram buckets
+#endif
+
+/**************************************************************************/
+/*!
+    @brief  named regions that the profiling probes record into
+*/
+/**************************************************************************/
+typedef enum _I2SProfileRegion {
+  I2S_PROF_BEGIN_SYNC = 0, ///< SYNCBUSY waits in begin()
+  I2S_PROF_ENABLE_TX,      ///< enableTx()
+  I2S_PROF_ENABLE_RX,      ///< enableRx()
+  I2S_PROF_DISABLE,        ///< disableTx() and disableRx() on SAMD51
+  I2S_PROF_WRITE,          ///< blocking write(), mostly waiting for TXRDY
+  I2S_PROF_READ,           ///< blocking read(), mostly waiting for RXRDY
+  I2S_PROF_DMA_CALLBACK,   ///< DMA completion handlers, probed by the sketch
+  I2S_PROF_USER,           ///< free for the sketch to use
+  I2S_PROF_NUM_REGIONS     ///< number of regions, not a region itself
+} I2SProfileRegion;
+
+/**************************************************************************/
+/*!
+    @brief  statistics kept for each profiled region
+*/
+/**************************************************************************/
+typedef struct _I2SProfileStats {
+  uint32_t count;                         ///< number of samples
+  uint32_t min;                           ///< shortest sample in cycles
+  uint32_t max;                           ///< longest sample in cycles
+  uint64_t total;                         ///< sum of all samples in cycles
+  uint32_t hist[ZEROI2S_PROFILE_BUCKETS]; ///< samples per log2 bucket
+} I2SProfileStats;
+
+#if ZEROI2S_PROFILE
+
+void zeroi2s_profile_init();
+void zeroi2s_profile_reset();
+void zeroi2s_profile_record(I2SProfileRegion region, uint32_t cycles);
+bool zeroi2s_profile_stats(I2SProfileRegion region, I2SProfileStats *out);
+void zeroi2s_profile_dump(Print &out = Serial);
+
+/**************************************************************************/
+/*!
+    @brief  records the cycles between its construction and destruction
+*/
+/**************************************************************************/
+class Adafruit_ZeroI2S_ProfileScope {
+public:
+  /**************************************************************************/
+  /*!
+      @brief  start timing
+      @param region the region to record into when this goes out of scope
+  */
+  /**************************************************************************/
+  Adafruit_ZeroI2S_ProfileScope(I2SProfileRegion region)
+      : _region(region), _start(zeroi2s_cycles_now()) {}
+  ~Adafruit_ZeroI2S_ProfileScope() {
+    zeroi2s_profile_record(_region, zeroi2s_cycles_now() - _start);
+  }
+
+private:
+  I2SProfileRegion _region;
+  uint32_t _start;
+};
+
+/// enable the cycle counter
+#define ZEROI2S_PROFILE_INIT() zeroi2s_profile_init()
+/// time from here to the end of the enclosing block
+#define ZEROI2S_PROFILE_SCOPE(region)                                          \
+  Adafruit_ZeroI2S_ProfileScope _zeroi2s_scope(region)
+/// start timing into the local variable var
+#define ZEROI2S_PROFILE_START(var) uint32_t var = zeroi2s_cycles_now()
+/// record the time since ZEROI2S_PROFILE_START(var) into region
+#define ZEROI2S_PROFILE_END(region, var)                                       \
+  zeroi2s_profile_record(region, zeroi2s_cycles_now() - var)
+
+#else
+
+// Profiling is disabled: the probes vanish and the API does nothing, so
+// sketches can leave their calls in place.
+#define ZEROI2S_PROFILE_INIT()           ///< profiling disabled
+#define ZEROI2S_PROFILE_SCOPE(region)    ///< profiling disabled
+#define ZEROI2S_PROFILE_START(var)       ///< profiling disabled
+#define ZEROI2S_PROFILE_END(region, var) ///< profiling disabled
+
+/// profiling disabled, does nothing
+static inline void zeroi2s_profile_init() {}
+/// profiling disabled, does nothing
+static inline void zeroi2s_profile_reset() {}
+/// profiling disabled, does nothing
+static inline void zeroi2s_profile_record(I2SProfileRegion region,
+                                          uint32_t cycles) {
+  (void)region;
+  (void)cycles;
+}
+/// profiling disabled, there are no statistics
+static inline bool zeroi2s_profile_stats(I2SProfileRegion region,
+                                         I2SProfileStats *out) {
+  (void)region;
+  (void)out;
+  return false;
+}
+/// profiling disabled, does nothing
+static inline void zeroi2s_profile_dump(Print &out = Serial) { (void)out; }
+
+#endif
+
+#endif
@@ -16,7 +16,12 @@ ZeroDMAstatus    stat; // DMA status codes returned by some functions
 Adafruit_ZeroI2S i2s;
 
 void dma_callback(Adafruit_ZeroDMA *dma) {
-  /* we don't need to do anything here */
+  /* time spent in here is recorded when the library is built with
+   * -DZEROI2S_PROFILE=1, and this line does nothing otherwise
+   */
+  ZEROI2S_PROFILE_SCOPE(I2S_PROF_DMA_CALLBACK);
+
+  /* we don't need to do anything else here */
 }
 
 void setup()
@@ -73,5 +78,6 @@ void setup()
 void loop()
 {
   Serial.println("do other things here while your DMA runs in the background.");
+  zeroi2s_profile_dump(Serial); /* prints nothing unless profiling is on */
   delay(2000);
 }
@@ -0,0 +1,45 @@
+#include <Arduino.h>
+
+#include <Adafruit_ZeroI2S.h>
+
+/* Print where the driver spends its time. Profiling has to be turned on
+ * when the library is compiled, so build with -DZEROI2S_PROFILE=1 (a
+ * #define in this sketch isn't enough), otherwise nothing is printed.
+ * With arduino-cli that is:
+ *   arduino-cli compile --build-property \
+ *     "compiler.cpp.extra_flags=-DZEROI2S_PROFILE=1" ...
+ */
+
+#define BUFSIZE 128
+
+// Use default pins in board variant
+Adafruit_ZeroI2S i2s = Adafruit_ZeroI2S();
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println("I2S profiling demo");
+
+  i2s.begin(I2S_32_BIT, 44100);
+  i2s.enableTx();
+}
+
+void loop()
+{
+  zeroi2s_profile_reset();
+
+  for (int i = 0; i < BUFSIZE; i++) {
+    i2s.write(0, 0);
+  }
+
+  /* your own code can be timed too, e.g. an audio or DMA callback */
+  {
+    ZEROI2S_PROFILE_SCOPE(I2S_PROF_USER);
+    delayMicroseconds(50);
+  }
+
+  zeroi2s_profile_dump(Serial);
+  delay(2000);
+}
@@ -0,0 +1,50 @@
+#include <Arduino.h>
+
+#include <Adafruit_ZeroI2S.h>
+
+/* Run as an I2S slave: the codec (or any other I2S master) drives the bit
+ * clock and frame sync pins, so the sample rate is exactly the codec's.
+ */
+
+// Use default pins in board variant
+Adafruit_ZeroI2S i2s = Adafruit_ZeroI2S();
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println("I2S slave demo");
+
+  /* take SCK and FS from the pins, the sample rate argument is ignored.
+   *
+   * Alternatively on SAMD51 boards with an MCK pin, I2S_CLOCK_MCK_IN takes
+   * only MCK from the codec. We then stay the SCK/FS master but divide them
+   * down from that MCK, so the rate is MCK / 256 and locked to the codec:
+   *   i2s.begin(I2S_32_BIT, 0, 256, I2S_CLOCK_MCK_IN);
+   */
+  if (!i2s.begin(I2S_32_BIT, 0, 256, I2S_CLOCK_SLAVE)) {
+    Serial.println("Failed to start I2S!");
+    while (1) delay(10);
+  }
+  i2s.enableTx();
+}
+
+void loop()
+{
+  /* report the rate the master is running at */
+  uint32_t rate = i2s.measureSampleRate();
+  if (rate) {
+    Serial.print("Sample rate: ");
+    Serial.print(rate);
+    Serial.println(" Hz");
+  } else {
+    Serial.println("No frame sync, is the master running?");
+  }
+
+  /* send some silence for a second */
+  for (uint32_t i = 0; i < rate; i++) {
+    i2s.write(0, 0);
+  }
+  delay(1000);
+}